@@ -0,0 +1,404 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "partial_vector.h"
+
+// Fixed-size payload to measure how element size affects each container
+template<size_t ByteSize>
+struct bench_element {
+    uint64_t data[ByteSize / sizeof(uint64_t)];
+
+    bench_element() noexcept : data {} {}
+
+    bench_element(uint64_t value) noexcept {
+        std::fill(std::begin(data), std::end(data), value);
+    }
+
+    friend bool operator<(bench_element const& a, bench_element const& b) noexcept {
+        return a.data[0] < b.data[0];
+    }
+};
+
+struct bench_config {
+    size_t min_size    = 1000;
+    size_t max_size    = 100000000;
+    size_t max_bytes   = size_t(1) << 30; // upper bound for size * element size of a single container
+    size_t ops         = 1000;            // random inserts/removes per measurement
+    size_t access_ops  = 1000000;         // random operator[] reads per measurement
+    size_t repeats     = 5;               // minimum measured rounds per cell, after one warm-up round
+    size_t max_repeats = 100;
+    size_t min_time_ms = 100; // rounds repeat until their total time reaches this, up to max_repeats
+    size_t tie_percent = 5;   // part sizes whose medians differ by less than this are considered equally fast
+};
+
+struct bench_result {
+    const char* workload;
+    const char* container;
+    size_t      element_size;
+    size_t      size;
+    uint32_t    part_byte_size; // 0 for non-partial containers
+    size_t      repeats;
+    double      ns_per_op;      // median of all runs
+    double      min_ns_per_op;
+    double      max_ns_per_op;
+};
+
+static bench_config              config;
+static std::vector<bench_result> results;
+
+// Accumulates values read by the workloads, so that the compiler can't drop them
+static uint64_t sink = 0;
+
+static const char* const workload_names[] = { "push_back", "random_insert", "random_remove", "random_access",
+                                              "iterate",   "to_vector",     "sort",          "copy" };
+
+class bench_timer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+public:
+    double elapsed_ns() const {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+template<typename T>
+static size_t container_size(std::vector<T> const& c) {
+    return c.size();
+}
+
+template<typename T>
+static size_t container_size(std::deque<T> const& c) {
+    return c.size();
+}
+
+template<typename T, uint32_t I, uint32_t P, typename E>
+static size_t container_size(partial_vector<T, I, P, E> const& c) {
+    return c.get_size();
+}
+
+template<typename T>
+static void insert_at(std::vector<T>& c, size_t index, T const& element) {
+    c.insert(c.begin() + index, element);
+}
+
+template<typename T>
+static void insert_at(std::deque<T>& c, size_t index, T const& element) {
+    c.insert(c.begin() + index, element);
+}
+
+template<typename T, uint32_t I, uint32_t P, typename E>
+static void insert_at(partial_vector<T, I, P, E>& c, size_t index, T const& element) {
+    c.insert(c.begin() + index, element);
+}
+
+template<typename T>
+static void remove_at(std::vector<T>& c, size_t index) {
+    c.erase(c.begin() + index);
+}
+
+template<typename T>
+static void remove_at(std::deque<T>& c, size_t index) {
+    c.erase(c.begin() + index);
+}
+
+template<typename T, uint32_t I, uint32_t P, typename E>
+static void remove_at(partial_vector<T, I, P, E>& c, size_t index) {
+    c.remove(index);
+}
+
+template<typename T>
+static std::vector<T> copy_to_vector(std::vector<T> const& c) {
+    return std::vector<T>(c);
+}
+
+template<typename T>
+static std::vector<T> copy_to_vector(std::deque<T> const& c) {
+    return std::vector<T>(c.begin(), c.end());
+}
+
+template<typename T, uint32_t I, uint32_t P, typename E>
+static std::vector<T> copy_to_vector(partial_vector<T, I, P, E> const& c) {
+    return c.to_vector();
+}
+
+template<typename ContainerT, typename ElementT>
+static void fill_random(ContainerT& c, size_t size, std::mt19937_64& rng) {
+    for (size_t i = 0; i < size; i++)
+        c.push_back(ElementT(rng()));
+}
+
+// Returns time per operation in nanoseconds
+template<typename ContainerT, typename ElementT>
+static double run_workload(size_t workload, size_t size, std::mt19937_64& rng) {
+    ContainerT c;
+
+    if (workload == 0) { // push_back
+        bench_timer timer;
+        fill_random<ContainerT, ElementT>(c, size, rng);
+        double elapsed = timer.elapsed_ns();
+
+        sink += c[size - 1].data[0];
+        return elapsed / size;
+    }
+
+    fill_random<ContainerT, ElementT>(c, size, rng);
+
+    switch (workload) {
+    case 1: { // random_insert
+        std::vector<size_t> indices(config.ops);
+        for (size_t i = 0; i < config.ops; i++)
+            indices[i] = rng() % (size + i + 1);
+
+        bench_timer timer;
+        for (size_t i = 0; i < config.ops; i++)
+            insert_at(c, indices[i], ElementT(i));
+        double elapsed = timer.elapsed_ns();
+
+        sink += container_size(c);
+        return elapsed / config.ops;
+    }
+    case 2: { // random_remove
+        size_t              ops = std::min(config.ops, size / 2);
+        std::vector<size_t> indices(ops);
+        for (size_t i = 0; i < ops; i++)
+            indices[i] = rng() % (size - i);
+
+        bench_timer timer;
+        for (size_t i = 0; i < ops; i++)
+            remove_at(c, indices[i]);
+        double elapsed = timer.elapsed_ns();
+
+        sink += container_size(c);
+        return elapsed / ops;
+    }
+    case 3: { // random_access
+        std::vector<size_t> indices(config.access_ops);
+        for (auto& index : indices)
+            index = rng() % size;
+
+        uint64_t    sum = 0;
+        bench_timer timer;
+        for (size_t index : indices)
+            sum += c[index].data[0];
+        double elapsed = timer.elapsed_ns();
+
+        sink += sum;
+        return elapsed / config.access_ops;
+    }
+    case 4: { // iterate
+        uint64_t    sum = 0;
+        bench_timer timer;
+        for (auto& element : c)
+            sum += element.data[0];
+        double elapsed = timer.elapsed_ns();
+
+        sink += sum;
+        return elapsed / size;
+    }
+    case 5: { // to_vector
+        bench_timer timer;
+        auto        data    = copy_to_vector(c);
+        double      elapsed = timer.elapsed_ns();
+
+        sink += data[size / 2].data[0];
+        return elapsed / size;
+    }
+    case 6: { // sort
+        bench_timer timer;
+        std::sort(c.begin(), c.end());
+        double elapsed = timer.elapsed_ns();
+
+        sink += c[0].data[0];
+        return elapsed / size;
+    }
+    default: { // copy
+        bench_timer timer;
+        ContainerT  c_copy(c);
+        double      elapsed = timer.elapsed_ns();
+
+        sink += c_copy[size / 2].data[0];
+        return elapsed / size;
+    }
+    }
+}
+
+struct bench_candidate {
+    const char* container;
+    uint32_t    part_byte_size;
+    double (*run)(size_t workload, size_t size, std::mt19937_64& rng);
+};
+
+// Candidates of a cell are run in interleaved rounds, so that drift over time (CPU frequency, allocator state)
+// affects all of them equally. Every run works on a fresh container, and every candidate of a round
+// replays the same random sequence seeded from (size, workload, round).
+template<typename ElementT>
+static void run_cell(std::vector<bench_candidate> const& candidates, size_t workload, size_t size) {
+    auto run_seeded = [workload, size](bench_candidate const& candidate, size_t round) {
+        std::seed_seq   seed { uint64_t(size), uint64_t(workload), uint64_t(round) };
+        std::mt19937_64 rng(seed);
+        return candidate.run(workload, size, rng);
+    };
+
+    // Warm-up runs, not measured
+    for (auto const& candidate : candidates)
+        run_seeded(candidate, 0);
+
+    std::vector<std::vector<double>> runs(candidates.size());
+    double                           total_ns = 0;
+
+    for (size_t round = 0; round < config.max_repeats && (round < config.repeats || total_ns < config.min_time_ms * 1e6); round++) {
+        bench_timer timer;
+        for (size_t i = 0; i < candidates.size(); i++)
+            runs[i].push_back(run_seeded(candidates[i], round));
+        total_ns += timer.elapsed_ns();
+    }
+
+    for (size_t i = 0; i < candidates.size(); i++) {
+        auto& candidate_runs = runs[i];
+        std::sort(candidate_runs.begin(), candidate_runs.end());
+
+        size_t n      = candidate_runs.size();
+        double median = n % 2 == 1 ? candidate_runs[n / 2] : (candidate_runs[n / 2 - 1] + candidate_runs[n / 2]) / 2;
+
+        results.push_back(bench_result { workload_names[workload], candidates[i].container, sizeof(ElementT), size,
+                                         candidates[i].part_byte_size, n, median, candidate_runs.front(), candidate_runs.back() });
+    }
+}
+
+template<typename ElementT, uint32_t... PartByteSizes>
+static void run_element_size() {
+    std::vector<bench_candidate> candidates = {
+        { "std::vector", 0, &run_workload<std::vector<ElementT>, ElementT> },
+        { "std::deque", 0, &run_workload<std::deque<ElementT>, ElementT> },
+        { "partial_vector", PartByteSizes, &run_workload<partial_vector<ElementT, 0, PartByteSizes>, ElementT> }...,
+    };
+
+    for (size_t size = config.min_size; size <= config.max_size; size *= 10) {
+        if (size * sizeof(ElementT) > config.max_bytes) break;
+
+        for (size_t workload = 0; workload < std::size(workload_names); workload++)
+            run_cell<ElementT>(candidates, workload, size);
+
+        fprintf(stderr, "  element_size=%-4zu size=%zu\n", sizeof(ElementT), size);
+    }
+}
+
+template<uint32_t... PartByteSizes>
+static void run_all() {
+    run_element_size<bench_element<8>, PartByteSizes...>();
+    run_element_size<bench_element<32>, PartByteSizes...>();
+    run_element_size<bench_element<128>, PartByteSizes...>();
+}
+
+static void print_json() {
+    printf("{\n  \"config\": {\"min_size\": %zu, \"max_size\": %zu, \"max_bytes\": %zu, \"ops\": %zu, \"access_ops\": %zu, "
+           "\"repeats\": %zu, \"max_repeats\": %zu, \"min_time_ms\": %zu, \"tie_percent\": %zu},\n",
+           config.min_size, config.max_size, config.max_bytes, config.ops, config.access_ops, config.repeats, config.max_repeats,
+           config.min_time_ms, config.tie_percent);
+
+    printf("  \"results\": [");
+    for (size_t i = 0; i < results.size(); i++) {
+        auto const& r = results[i];
+        printf("%s\n    {\"workload\": \"%s\", \"container\": \"%s\", \"element_size\": %zu, \"size\": %zu, \"part_byte_size\": %u, "
+               "\"repeats\": %zu, \"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, \"max_ns_per_op\": %.3f}",
+               i == 0 ? "" : ",", r.workload, r.container, r.element_size, r.size, r.part_byte_size, r.repeats, r.ns_per_op, r.min_ns_per_op,
+               r.max_ns_per_op);
+    }
+    printf("\n  ],\n");
+
+    // For every (workload, element_size, size): part sizes within tie_percent of the lowest median are considered tied,
+    // the smallest of them is reported as best, so that the choice doesn't flip between runs because of noise
+    printf("  \"best_part_byte_size\": [");
+    bool first = true;
+    for (size_t i = 0; i < results.size(); i++) {
+        auto const& r = results[i];
+        if (r.part_byte_size == 0) continue;
+
+        auto same_cell = [&r](bench_result const& other) {
+            return other.part_byte_size != 0 && other.workload == r.workload && other.element_size == r.element_size && other.size == r.size;
+        };
+
+        // Handle every cell once, at its first result
+        bool is_first_in_cell = true;
+        for (size_t j = 0; j < i; j++)
+            if (same_cell(results[j])) is_first_in_cell = false;
+        if (!is_first_in_cell) continue;
+
+        double fastest_ns_per_op = r.ns_per_op;
+        for (auto const& other : results)
+            if (same_cell(other)) fastest_ns_per_op = std::min(fastest_ns_per_op, other.ns_per_op);
+
+        double              tie_ns_per_op = fastest_ns_per_op * (1 + config.tie_percent / 100.0);
+        bench_result const* best          = nullptr;
+        std::string         tied;
+        for (auto const& other : results) {
+            if (!same_cell(other) || other.ns_per_op > tie_ns_per_op) continue;
+
+            if (best == nullptr || other.part_byte_size < best->part_byte_size) best = &other;
+            tied += (tied.empty() ? "" : ", ") + std::to_string(other.part_byte_size);
+        }
+
+        printf("%s\n    {\"workload\": \"%s\", \"element_size\": %zu, \"size\": %zu, \"part_byte_size\": %u, \"ns_per_op\": %.3f, "
+               "\"tied_part_byte_sizes\": [%s]}",
+               first ? "" : ",", r.workload, r.element_size, r.size, best->part_byte_size, best->ns_per_op, tied.c_str());
+        first = false;
+    }
+    printf("\n  ]\n}\n");
+}
+
+static bool parse_args(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        size_t* value = nullptr;
+
+        if (strcmp(argv[i], "--min-size") == 0)
+            value = &config.min_size;
+        else if (strcmp(argv[i], "--max-size") == 0)
+            value = &config.max_size;
+        else if (strcmp(argv[i], "--max-bytes") == 0)
+            value = &config.max_bytes;
+        else if (strcmp(argv[i], "--ops") == 0)
+            value = &config.ops;
+        else if (strcmp(argv[i], "--access-ops") == 0)
+            value = &config.access_ops;
+        else if (strcmp(argv[i], "--repeats") == 0)
+            value = &config.repeats;
+        else if (strcmp(argv[i], "--max-repeats") == 0)
+            value = &config.max_repeats;
+        else if (strcmp(argv[i], "--min-time-ms") == 0)
+            value = &config.min_time_ms;
+        else if (strcmp(argv[i], "--tie-percent") == 0)
+            value = &config.tie_percent;
+
+        if (value == nullptr || i + 1 >= argc) return false;
+
+        char* end = nullptr;
+        *value    = strtoull(argv[++i], &end, 10);
+        if (*end != '\0') return false;
+    }
+
+    return config.min_size > 1 && config.ops > 0 && config.access_ops > 0 && config.repeats > 0 && config.max_repeats >= config.repeats;
+}
+
+int main(int argc, char** argv) {
+    if (!parse_args(argc, argv)) {
+        fprintf(stderr,
+                "Usage: %s [--min-size N] [--max-size N] [--max-bytes N] [--ops N] [--access-ops N] [--repeats N] [--max-repeats N] "
+                "[--min-time-ms N] [--tie-percent N]\n",
+                argv[0]);
+        return 1;
+    }
+
+    run_all<1024, 4096, 16384, 65536, 262144>();
+    print_json();
+
+    fprintf(stderr, "checksum: %llu\n", static_cast<unsigned long long>(sink));
+    return 0;
+}
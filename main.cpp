@@ -1,7 +1,9 @@
 #include <cassert>
 #include <iostream>
+#include <string>
 #include <vector>
 
+#include "partial_soa_vector.h"
 #include "partial_vector.h"
 
 static void pv_unit_0(uint32_t size) {
@@ -153,6 +155,251 @@ static void pv_unit_11(uint32_t size) {
         assert(data3[i] == i + 5);
 }
 
+static void pv_unit_12(uint32_t size) {
+    static_assert(sizeof(partial_vector<size_t, 16>) == sizeof(partial_vector<size_t>) + 16 * sizeof(size_t));
+
+    partial_vector<size_t, 16> v;
+    std::vector<size_t>        v_stl;
+
+    for (uint32_t i = 0; i < size; i++) {
+        size_t index = i % 2 == 0 ? 0 : v_stl.size() / 2;
+        v.insert(v.begin() + index, i);
+        v_stl.insert(v_stl.begin() + index, i);
+
+        if (v.get_size() <= 16) assert(v.get_part_count() == 0);
+    }
+
+    for (uint32_t i = 0; i < size; i++)
+        assert(v[i] == v_stl[i]);
+
+    partial_vector<size_t, 16> v2(v);
+    partial_vector<size_t, 16> v3;
+    v3 = v;
+
+    auto data = v3.to_vector(0);
+    for (uint32_t i = 0; i < size; i++)
+        assert(v2[i] == v_stl[i] && data[i] == v_stl[i]);
+
+    while (v.get_size() > 0) {
+        v.remove(v.get_size() / 2);
+        v_stl.erase(v_stl.begin() + v_stl.size() / 2);
+
+        for (uint32_t i = 0; i < v.get_size(); i++)
+            assert(v[i] == v_stl[i]);
+    }
+
+    assert(v.get_part_count() == 0);
+
+    v.resize(10);
+    assert(v.get_size() == 10 && v.get_part_count() == 0);
+}
+
+static void pv_unit_13(uint32_t size) {
+    partial_vector<std::string, 8> v;
+
+    for (uint32_t i = 0; i < size; i++)
+        v.push_back(std::to_string(i) + " long enough to avoid small string optimization");
+
+    v.insert(v.begin(), "first");
+
+    partial_vector<std::string, 8> v2(v);
+    v.clear();
+
+    assert(v.get_size() == 0 && v2.get_size() == size + 1);
+    assert(v2[0] == "first");
+
+    for (uint32_t i = 0; i < size; i++)
+        assert(v2[i + 1] == std::to_string(i) + " long enough to avoid small string optimization");
+
+    v = v2;
+    v.resize(4);
+    assert(v.get_size() == 4 && v[3] == v2[3]);
+}
+
+static void pv_unit_15(uint32_t size) {
+    static_assert(std::is_nothrow_move_constructible_v<partial_vector<std::string, 4>>);
+    static_assert(std::is_nothrow_move_assignable_v<partial_vector<size_t>>);
+
+    std::vector<partial_vector<std::string, 4>> vectors;
+
+    for (uint32_t i = 0; i < size; i++) {
+        vectors.emplace_back();
+        for (uint32_t j = 0; j < i % 8; j++)
+            vectors.back().push_back(std::to_string(j) + " long enough to avoid small string optimization");
+    }
+
+    for (uint32_t i = 0; i < size; i++) {
+        assert(vectors[i].get_size() == i % 8);
+        for (uint32_t j = 0; j < i % 8; j++)
+            assert(vectors[i][j] == std::to_string(j) + " long enough to avoid small string optimization");
+    }
+
+    partial_vector<std::string, 4> v(std::move(vectors[size - 1]));
+    assert(v.get_size() == (size - 1) % 8 && vectors[size - 1].get_size() == 0);
+
+    vectors[0] = std::move(v);
+    assert(vectors[0].get_size() == (size - 1) % 8 && v.get_size() == 0);
+
+    v.push_back("reused");
+    assert(v.get_size() == 1 && v[0] == "reused");
+}
+
+// Counts live objects, copies and moves throw after a given number of successful ones
+struct throwing_element {
+    static int live_count;
+    static int copies_left;
+    static int moves_left;
+
+    int value = 0;
+
+    throwing_element(int value = 0) : value(value) {
+        live_count++;
+    }
+
+    throwing_element(throwing_element const& another) : value(another.value) {
+        if (copies_left-- == 0) throw std::runtime_error("copy");
+        live_count++;
+    }
+
+    throwing_element(throwing_element&& another) : value(another.value) {
+        if (moves_left-- == 0) throw std::runtime_error("move");
+        live_count++;
+    }
+
+    throwing_element& operator=(throwing_element const&) = default;
+    throwing_element& operator=(throwing_element&&)      = default;
+
+    ~throwing_element() {
+        live_count--;
+    }
+};
+
+int throwing_element::live_count  = 0;
+int throwing_element::copies_left = INT32_MAX;
+int throwing_element::moves_left  = INT32_MAX;
+
+static void pv_unit_16() {
+    {
+        partial_vector<throwing_element, 8> a;
+        for (int i = 0; i < 5; i++)
+            a.push_back(i);
+
+        partial_vector<throwing_element, 8> b;
+        b.push_back(100);
+
+        throwing_element::copies_left = 2;
+        bool thrown                   = false;
+        try {
+            b = a;
+        } catch (std::runtime_error const&) {
+            thrown = true;
+        }
+        throwing_element::copies_left = INT32_MAX;
+
+        assert(thrown && b.get_size() == 0);
+        assert(throwing_element::live_count == 5);
+
+        b = a;
+        assert(b.get_size() == 5 && b[4].value == 4);
+
+        static_assert(!std::is_nothrow_move_constructible_v<partial_vector<throwing_element, 8>>);
+
+        throwing_element::moves_left = 2;
+        thrown                       = false;
+        try {
+            partial_vector<throwing_element, 8> c(std::move(a));
+        } catch (std::runtime_error const&) {
+            thrown = true;
+        }
+        throwing_element::moves_left = INT32_MAX;
+
+        assert(thrown && a.get_size() == 5);
+        assert(throwing_element::live_count == 10);
+
+        throwing_element::moves_left = 2;
+        thrown                       = false;
+        try {
+            b = std::move(a);
+        } catch (std::runtime_error const&) {
+            thrown = true;
+        }
+        throwing_element::moves_left = INT32_MAX;
+
+        assert(thrown && b.get_size() == 0 && a.get_size() == 5);
+        assert(throwing_element::live_count == 5);
+
+        b = std::move(a);
+        assert(b.get_size() == 5 && a.get_size() == 0 && b[4].value == 4);
+        assert(throwing_element::live_count == 5);
+    }
+    assert(throwing_element::live_count == 0);
+}
+
+#ifdef PARTIAL_VECTOR_ENABLE_STATS
+static void pv_unit_14(uint32_t size) {
+    const uint32_t max_part_size = PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / sizeof(size_t);
+
+    partial_vector<size_t> v;
+
+    for (uint32_t i = 0; i < size; i++)
+        v.push_back(i);
+
+    auto stats0 = v.stats();
+    assert(stats0.element_count == size && stats0.part_count == v.get_part_count());
+    assert(stats0.allocations >= v.get_part_count() && stats0.allocated_bytes >= size * sizeof(size_t));
+    assert(stats0.part_occupancy[partial_vector_stats::occupancy_bucket_count - 1] == size / max_part_size);
+
+    for (uint32_t i = 0; i < size; i++)
+        assert(v[i] == i);
+
+    auto stats1 = v.stats();
+    assert(stats1.find_element_calls == size);
+    assert(stats1.offset_cache_rebuilds == v.get_part_count());
+    // Every part offset is computed once, by the first lookup that reaches the part
+    assert(stats1.offset_cache_hits == size - v.get_part_count());
+
+    uint64_t probes = 0;
+    for (auto count : stats1.find_element_parts_scanned)
+        probes += count;
+    assert(probes == size);
+
+    uint32_t part_count = v.get_part_count();
+    v.insert(v.begin(), 0);
+
+    auto stats2 = v.stats();
+    assert(stats2.insert_element_moves >= std::min(size, max_part_size));
+    assert(stats2.offset_cache_invalidations == (part_count > 1 ? 1 : 0));
+
+    // Lookups of a warm cache are hits regardless of how many parts they scan
+    v.reset_stats();
+    for (uint32_t i = 0; i < v.get_size(); i++)
+        v[i];
+    v.reset_stats();
+    for (uint32_t i = 0; i < v.get_size(); i++)
+        v[i];
+    assert(v.stats().offset_cache_hits == v.get_size() && v.stats().offset_cache_rebuilds == 0);
+
+    v.reset_stats();
+    assert(v.stats().find_element_calls == 0 && v.stats().allocations == 0);
+
+    // Empty non-inline vector: lookup scans no parts, it is counted but not put into the histogram
+    partial_vector<size_t> v_empty;
+    v_empty.reserve(max_part_size * 2);
+    v_empty.begin() + 0;
+    assert(v_empty.stats().find_element_calls == 1);
+    for (auto count : v_empty.stats().find_element_parts_scanned)
+        assert(count == 0);
+
+    // Lookups in inline storage are counted too
+    partial_vector<size_t, 8> v_inline;
+    for (uint32_t i = 0; i < 8; i++)
+        v_inline.push_back(i);
+    for (uint32_t i = 0; i < 8; i++)
+        assert(v_inline[i] == i);
+    assert(v_inline.stats().find_element_calls == 8 && v_inline.stats().offset_cache_hits == 0);
+}
+#endif
+
 static void partial_vector_unit_tests() {
     pv_unit_0(10);
     pv_unit_0(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 8);
@@ -213,17 +460,178 @@ static void partial_vector_unit_tests() {
     pv_unit_11(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 8);
     pv_unit_11(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 8 + 10);
     pv_unit_11(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 8 * 10 + 10);
+
+    pv_unit_12(10);
+    pv_unit_12(16);
+    pv_unit_12(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 8 + 10);
+
+    pv_unit_13(4);
+    pv_unit_13(8);
+    pv_unit_13(100);
+
+    pv_unit_15(10);
+    pv_unit_15(1000);
+
+    pv_unit_16();
+
+#ifdef PARTIAL_VECTOR_ENABLE_STATS
+    pv_unit_14(10);
+    pv_unit_14(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 8);
+    pv_unit_14(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 8 * 10 + 10);
+#endif
+}
+
+typedef partial_soa_vector<size_t, uint32_t, double> test_soa_vector;
+
+static void sv_unit_0(uint32_t size) {
+    test_soa_vector v;
+
+    for (uint32_t i = 0; i < size; i++)
+        v.push_back(i, i * 2, i * 0.5);
+
+    assert(v.get_size() == size);
+
+    for (uint32_t i = 0; i < size; i++) {
+        assert(v.get<0>(i) == i);
+        assert(v.get<1>(i) == i * 2);
+        assert(v.get<2>(i) == i * 0.5);
+        assert(v.get_row(i) == std::make_tuple(size_t(i), uint32_t(i * 2), i * 0.5));
+    }
+}
+
+static void sv_unit_1(uint32_t size) {
+    test_soa_vector     v;
+    std::vector<size_t> v_stl;
+
+    for (uint32_t i = 0; i < size; i++) {
+        size_t index = i % 3 == 0 ? 0 : v_stl.size() / 2;
+        v.insert(index, i, i * 2, i * 0.5);
+        v_stl.insert(v_stl.begin() + index, i);
+    }
+
+    assert(v.get_size() == size);
+
+    for (uint32_t i = 0; i < size; i++) {
+        assert(v.get<0>(i) == v_stl[i]);
+        assert(v.get<1>(i) == v_stl[i] * 2);
+        assert(v.get<2>(i) == v_stl[i] * 0.5);
+    }
+}
+
+static void sv_unit_2(uint32_t size) {
+    test_soa_vector     v;
+    std::vector<size_t> v_stl;
+
+    for (uint32_t i = 0; i < size; i++) {
+        v.push_back(i, i * 2, i * 0.5);
+        v_stl.push_back(i);
+    }
+
+    while (v.get_size() > size / 4) {
+        size_t index = v_stl.size() % 2 == 0 ? 0 : v_stl.size() / 2;
+        v.remove(index);
+        v_stl.erase(v_stl.begin() + index);
+    }
+
+    for (uint32_t i = 0; i < v.get_size(); i++) {
+        assert(v.get<0>(i) == v_stl[i]);
+        assert(v.get<1>(i) == v_stl[i] * 2);
+        assert(v.get<2>(i) == v_stl[i] * 0.5);
+    }
+
+    while (v.get_size() > 0)
+        v.remove(v.get_size() - 1);
+
+    assert(v.get_part_count() == 0);
+}
+
+static void sv_unit_3(uint32_t size) {
+    test_soa_vector v;
+
+    for (uint32_t i = 0; i < size; i++)
+        v.push_back(i, i * 2, i * 0.5);
+
+    size_t   sum           = 0;
+    size_t   element_count = 0;
+    uint32_t segment_count = 0;
+
+    v.for_each_column_segment<1>([&](auto segment) {
+        for (auto value : segment)
+            sum += value;
+
+        element_count += segment.size;
+        segment_count++;
+    });
+
+    assert(element_count == size);
+    assert(segment_count == v.get_part_count());
+    assert(sum == static_cast<size_t>(size) * (size - 1));
+
+    auto column = v.column_to_vector<0>();
+    for (uint32_t i = 0; i < size; i++)
+        assert(column[i] == i);
+}
+
+static void sv_unit_4(uint32_t size) {
+    test_soa_vector v(size);
+    assert(v.get_size() == size);
+
+    for (uint32_t i = 0; i < size; i++)
+        v.get<0>(i) = i;
+
+    v.resize(size / 2);
+    assert(v.get_size() == size / 2);
+
+    v.resize(size * 2);
+    assert(v.get_size() == size * 2);
+
+    for (uint32_t i = 0; i < size / 2; i++)
+        assert(v.get<0>(i) == i);
+
+    for (uint32_t i = size / 2; i < size * 2; i++)
+        assert(v.get<0>(i) == 0 && v.get<1>(i) == 0 && v.get<2>(i) == 0);
+
+    v.clear();
+    assert(v.get_size() == 0 && v.get_part_count() == 0);
+}
+
+static void partial_soa_vector_unit_tests() {
+    sv_unit_0(10);
+    sv_unit_0(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20);
+    sv_unit_0(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20 + 10);
+    sv_unit_0(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20 * 10 + 10);
+
+    sv_unit_1(10);
+    sv_unit_1(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20);
+    sv_unit_1(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20 + 10);
+    sv_unit_1(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20 * 10 + 10);
+
+    sv_unit_2(10);
+    sv_unit_2(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20);
+    sv_unit_2(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20 + 10);
+    sv_unit_2(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20 * 10 + 10);
+
+    sv_unit_3(10);
+    sv_unit_3(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20);
+    sv_unit_3(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20 + 10);
+    sv_unit_3(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20 * 10 + 10);
+
+    sv_unit_4(10);
+    sv_unit_4(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20);
+    sv_unit_4(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20 + 10);
+    sv_unit_4(PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 20 * 10 + 10);
 }
 
 #include <algorithm>
 
 int main() {
     partial_vector_unit_tests();
+    partial_soa_vector_unit_tests();
 
     // std::vector<int> aa;
 
     partial_vector<int> aa({ 5, 8, 2, 3 });
-    aa.to_vector() auto dd  = aa.begin() + 5;
+    auto                dd  = aa.begin() + 5;
     auto                dd3 = aa.end() + 8;
     auto                dd4 = dd3 - dd;
 
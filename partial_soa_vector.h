@@ -0,0 +1,296 @@
+#ifndef PARTIAL_VECTOR__PARTIAL_SOA_VECTOR_H
+#define PARTIAL_VECTOR__PARTIAL_SOA_VECTOR_H
+
+#include <tuple>
+#include <utility>
+
+#include "partial_vector.h"
+
+// Structure-of-arrays counterpart of partial_vector: every part stores one contiguous column per field,
+// so scans over a single field don't pull the other fields through the cache.
+// Minimum 2 rows per part
+template<typename... FieldTs>
+class partial_soa_vector {
+    static_assert(sizeof...(FieldTs) > 0, "partial_soa_vector requires at least one field");
+    static_assert((sizeof(FieldTs) + ...) <= PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 2, "Row is too large for a part");
+
+public:
+    typedef std::tuple<FieldTs...> row_type;
+
+    template<size_t FieldI>
+    using field_type = std::tuple_element_t<FieldI, row_type>;
+
+    // Contiguous range of a single column inside one part
+    template<typename FieldT>
+    struct column_span {
+        FieldT* data;
+        size_t  size;
+
+        FieldT* begin() const noexcept {
+            return data;
+        }
+
+        FieldT* end() const noexcept {
+            return data + size;
+        }
+
+        FieldT& operator[](size_t index) const noexcept {
+            return data[index];
+        }
+    };
+
+private:
+    static constexpr uint32_t max_part_size = PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / (sizeof(FieldTs) + ...);
+
+    typedef std::tuple<std::vector<FieldTs>...> Part;
+    typedef std::index_sequence_for<FieldTs...> FieldIndices;
+
+    std::vector<Part> parts;
+
+    size_t   size       = 0;
+    uint32_t part_count = 0;
+
+    mutable std::vector<size_t> part_offsets;
+
+    using ElementInfo = partial_vector_detail::ElementInfo;
+
+    static size_t part_size(Part const& part) noexcept {
+        return std::get<0>(part).size();
+    }
+
+    ElementInfo find_element(size_t element_index) const {
+        return partial_vector_detail::find_element(part_offsets, part_count, max_part_size, element_index,
+                                                   [this](uint32_t part_index) { return part_size(parts[part_index]); });
+    }
+
+    template<typename F>
+    static void for_each_column(Part& part, F const& f) {
+        std::apply([&f](auto&... columns) { (f(columns), ...); }, part);
+    }
+
+    template<size_t... Is>
+    static void insert_row(Part& part, uint32_t offset, row_type&& row, std::index_sequence<Is...>) {
+        (std::get<Is>(part).insert(std::get<Is>(part).begin() + offset, std::move(std::get<Is>(row))), ...);
+    }
+
+    template<size_t... Is>
+    static void push_back_row(Part& part, row_type&& row, std::index_sequence<Is...>) {
+        (std::get<Is>(part).push_back(std::move(std::get<Is>(row))), ...);
+    }
+
+    template<size_t... Is>
+    row_type get_row(ElementInfo const& elem_info, std::index_sequence<Is...>) const {
+        auto const& part = parts[elem_info.part_index];
+        return row_type(std::get<Is>(part)[elem_info.element_offset]...);
+    }
+
+    // Moves the last row of src_part to the front of dst_part
+    template<size_t... Is>
+    static void shift_last_row(Part& src_part, Part& dst_part, std::index_sequence<Is...>) {
+        (std::get<Is>(dst_part).insert(std::get<Is>(dst_part).begin(), std::move(std::get<Is>(src_part).back())), ...);
+        (std::get<Is>(src_part).pop_back(), ...);
+    }
+
+    void invalidate_part_offsets(uint32_t part_index) const noexcept {
+        // Offsets up to and including part_index stay valid
+        part_offsets.resize(std::min(part_offsets.size(), static_cast<size_t>(part_index) + 1));
+    }
+
+public:
+    explicit partial_soa_vector(size_t size = 0) {
+        resize(size);
+    }
+
+    void reserve(size_t r_size) {
+        uint32_t parts_to_reserve = std::ceil(static_cast<double>(r_size) / max_part_size);
+        parts.reserve(parts_to_reserve);
+        part_offsets.reserve(parts_to_reserve);
+    }
+
+    void shrink_to_fit() {
+        for (auto& part : parts)
+            for_each_column(part, [](auto& column) { column.shrink_to_fit(); });
+
+        parts.shrink_to_fit();
+        part_offsets.shrink_to_fit();
+    }
+
+    void resize(size_t new_size) {
+        if (this->size == new_size) return;
+
+        if (new_size > this->size) {
+            size_t size_to_alloc = new_size - this->size;
+
+            if (part_count > 0) {
+                auto&  last_part      = parts[part_count - 1];
+                size_t last_part_size = part_size(last_part);
+                size_t alloc_size     = std::min(static_cast<size_t>(max_part_size) - last_part_size, size_to_alloc);
+
+                for_each_column(last_part, [&](auto& column) { column.resize(last_part_size + alloc_size); });
+                size_to_alloc -= alloc_size;
+            }
+
+            while (size_to_alloc > 0) {
+                size_t alloc_size = std::min(size_to_alloc, static_cast<size_t>(max_part_size));
+
+                parts.emplace_back();
+                for_each_column(parts.back(), [alloc_size](auto& column) { column.resize(alloc_size); });
+                part_count++;
+
+                size_to_alloc -= alloc_size;
+            }
+        } else { // new_size < this->size
+            size_t size_to_remove = this->size - new_size;
+
+            while (size_to_remove > 0) {
+                auto&  last_part      = parts[part_count - 1];
+                size_t last_part_size = part_size(last_part);
+
+                if (last_part_size <= size_to_remove) {
+                    size_to_remove -= last_part_size;
+                    parts.pop_back();
+                    part_count--;
+                } else { // last_part_size > size_to_remove
+                    for_each_column(last_part, [&](auto& column) { column.resize(last_part_size - size_to_remove); });
+                    size_to_remove = 0;
+                }
+            }
+        }
+
+        part_offsets.resize(std::min(part_offsets.size(), static_cast<size_t>(part_count)));
+
+        this->size = new_size;
+    }
+
+    void clear() {
+        resize(0);
+    }
+
+    void push_back(FieldTs... fields) {
+        if (part_count == 0 || part_size(parts[part_count - 1]) == max_part_size) {
+            parts.emplace_back();
+            part_count++;
+        }
+
+        push_back_row(parts[part_count - 1], row_type(std::move(fields)...), FieldIndices());
+        size++;
+    }
+
+    void insert(size_t index, FieldTs... fields) {
+        if (index > size) throw std::runtime_error("Index > size");
+
+        if (index == size) {
+            push_back(std::move(fields)...);
+            return;
+        }
+
+        ElementInfo elem_info = find_element(index);
+
+        if (part_size(parts[elem_info.part_index]) == max_part_size) {
+            uint32_t part_n_index = elem_info.part_index + 1;
+
+            if (part_n_index >= part_count || part_size(parts[part_n_index]) == max_part_size) {
+                parts.emplace(parts.begin() + part_n_index);
+                part_count++;
+            }
+
+            shift_last_row(parts[elem_info.part_index], parts[part_n_index], FieldIndices());
+        }
+
+        insert_row(parts[elem_info.part_index], elem_info.element_offset, row_type(std::move(fields)...), FieldIndices());
+        invalidate_part_offsets(elem_info.part_index);
+
+        size++;
+    }
+
+    void remove(size_t index) {
+        if (index >= size) throw std::runtime_error("Index >= size");
+
+        ElementInfo elem_info = find_element(index);
+        auto&       part      = parts[elem_info.part_index];
+
+        for_each_column(part, [&elem_info](auto& column) { column.erase(column.begin() + elem_info.element_offset); });
+
+        if (part_size(part) == 0) {
+            parts.erase(parts.begin() + elem_info.part_index);
+            part_count--;
+        }
+
+        invalidate_part_offsets(elem_info.part_index);
+        size--;
+    }
+
+    template<size_t FieldI>
+    field_type<FieldI>& get(size_t index) {
+        if (index >= size) throw std::runtime_error("Index >= size");
+
+        ElementInfo elem_info = find_element(index);
+        return std::get<FieldI>(parts[elem_info.part_index])[elem_info.element_offset];
+    }
+
+    template<size_t FieldI>
+    field_type<FieldI> const& get(size_t index) const {
+        if (index >= size) throw std::runtime_error("Index >= size");
+
+        ElementInfo elem_info = find_element(index);
+        return std::get<FieldI>(parts[elem_info.part_index])[elem_info.element_offset];
+    }
+
+    row_type get_row(size_t index) const {
+        if (index >= size) throw std::runtime_error("Index >= size");
+
+        return get_row(find_element(index), FieldIndices());
+    }
+
+    template<size_t FieldI>
+    column_span<field_type<FieldI>> get_column_segment(uint32_t part_index) {
+        if (part_index >= part_count) throw std::runtime_error("PartIndex >= part_count");
+
+        auto& column = std::get<FieldI>(parts[part_index]);
+        return { column.data(), column.size() };
+    }
+
+    template<size_t FieldI>
+    column_span<const field_type<FieldI>> get_column_segment(uint32_t part_index) const {
+        if (part_index >= part_count) throw std::runtime_error("PartIndex >= part_count");
+
+        auto const& column = std::get<FieldI>(parts[part_index]);
+        return { column.data(), column.size() };
+    }
+
+    // Calls f(column_span) for every part in order. Each span is contiguous, which lets tight loops over it vectorize.
+    template<size_t FieldI, typename F>
+    void for_each_column_segment(F&& f) {
+        for (uint32_t i = 0; i < part_count; i++)
+            f(get_column_segment<FieldI>(i));
+    }
+
+    template<size_t FieldI, typename F>
+    void for_each_column_segment(F&& f) const {
+        for (uint32_t i = 0; i < part_count; i++)
+            f(get_column_segment<FieldI>(i));
+    }
+
+    template<size_t FieldI>
+    std::vector<field_type<FieldI>> column_to_vector() const {
+        std::vector<field_type<FieldI>> data;
+        data.reserve(size);
+
+        for (uint32_t i = 0; i < part_count; i++) {
+            auto const& column = std::get<FieldI>(parts[i]);
+            data.insert(data.end(), column.begin(), column.end());
+        }
+
+        return data;
+    }
+
+    size_t get_size() const noexcept {
+        return size;
+    }
+
+    uint32_t get_part_count() const noexcept {
+        return part_count;
+    }
+};
+
+#endif // PARTIAL_VECTOR__PARTIAL_SOA_VECTOR_H
@@ -1,41 +1,67 @@
 #ifndef PARTIAL_VECTOR__PARTIAL_VECTOR_H
 #define PARTIAL_VECTOR__PARTIAL_VECTOR_H
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
 #include <vector>
 
+#ifndef PARTIAL_VECTOR_PART_MAX_BYTE_SIZE
 #define PARTIAL_VECTOR_PART_MAX_BYTE_SIZE 16384
+#endif
+
+// Define PARTIAL_VECTOR_ENABLE_STATS to collect partial_vector::stats(); without it no counters are compiled in
+#ifdef PARTIAL_VECTOR_ENABLE_STATS
+#define PARTIAL_VECTOR_STATS_ONLY(...) __VA_ARGS__
+
+// Counters accumulate since construction or reset_stats(), occupancy and sizes are computed on snapshot
+struct partial_vector_stats {
+    static constexpr uint32_t occupancy_bucket_count = 10;
+    static constexpr uint32_t probe_bucket_count     = 16;
+
+    // Bucket i counts parts filled by [i * 10%, (i + 1) * 10%) of max part size, full parts go to the last bucket
+    uint64_t part_occupancy[occupancy_bucket_count] = {};
+    // Bucket i counts find_element calls that scanned [2^i, 2^(i + 1)) parts, lookups that scanned no parts aren't recorded
+    uint64_t find_element_parts_scanned[probe_bucket_count] = {};
+
+    uint64_t find_element_calls         = 0; // all lookups, including ones in inline storage or scanning no parts
+    uint64_t offset_cache_hits          = 0; // lookups that started from a cached part offset and didn't recompute any
+    uint64_t offset_cache_rebuilds      = 0; // part offsets recomputed because they were invalidated or not cached yet
+    uint64_t offset_cache_invalidations = 0; // insert/remove/resize calls that dropped cached part offsets
+    uint64_t allocations                = 0; // part storage (re)allocations
+    uint64_t allocated_bytes            = 0;
+    uint64_t insert_element_moves       = 0; // existing elements moved to make room for inserted ones
+
+    size_t   element_count = 0;
+    uint32_t part_count    = 0;
+};
+#else
+#define PARTIAL_VECTOR_STATS_ONLY(...)
+#endif
 
-// Minimum 2 elements per part
-template<typename ElementT, typename = typename std::enable_if<(sizeof(ElementT) <= PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / 2), ElementT>::type>
-class partial_vector {
-private:
-    const uint32_t max_part_size = PARTIAL_VECTOR_PART_MAX_BYTE_SIZE / sizeof(ElementT);
-
-    std::vector<std::vector<ElementT>> parts;
-
-    size_t   size       = 0;
-    uint32_t part_count = 0;
-
-    mutable std::vector<size_t> part_offsets;
-
+namespace partial_vector_detail {
     struct ElementInfo {
         uint32_t part_index;     // index from parts
         uint32_t element_offset; // offset relative to part
     };
 
-    ElementInfo find_element(size_t element_index) const {
+    // Shared by all partial containers: part_size(i) returns the element count of i-th part
+    template<typename PartSizeF>
+    ElementInfo find_element(std::vector<size_t>& part_offsets, uint32_t part_count, uint32_t max_part_size, size_t element_index,
+                             PartSizeF const& part_size) {
         uint32_t estimate_part_index  = part_offsets.size() == 0 ? 0 : std::min(part_offsets.size() - 1, element_index / max_part_size);
         size_t   estimate_part_offset = estimate_part_index == 0 ? 0 : part_offsets[estimate_part_index];
 
         if (estimate_part_offset > element_index) {
             for (int i = static_cast<int>(estimate_part_index) - 1; i >= 0; i--) {
-                auto& part = parts[i];
-                estimate_part_offset -= part.size();
+                size_t curr_part_size = part_size(i);
+                estimate_part_offset -= curr_part_size;
 
-                if (element_index >= estimate_part_offset && element_index < estimate_part_offset + part.size())
+                if (element_index >= estimate_part_offset && element_index < estimate_part_offset + curr_part_size)
                     return ElementInfo {
                         .part_index     = static_cast<uint32_t>(i),
                         .element_offset = static_cast<uint32_t>(element_index - estimate_part_offset),
@@ -43,26 +69,211 @@ private:
             }
         } else { // estimate_part_offset <= element_index
             for (uint32_t i = estimate_part_index; i < part_count; i++) {
-                auto& part = parts[i];
+                size_t curr_part_size = part_size(i);
 
                 // Save new part offset
                 if (i >= part_offsets.size()) part_offsets.push_back(estimate_part_offset);
 
-                if (element_index >= estimate_part_offset && element_index < estimate_part_offset + part.size())
+                if (element_index >= estimate_part_offset && element_index < estimate_part_offset + curr_part_size)
                     return ElementInfo {
                         .part_index     = static_cast<uint32_t>(i),
                         .element_offset = static_cast<uint32_t>(element_index - estimate_part_offset),
                     };
 
-                estimate_part_offset += part.size();
+                estimate_part_offset += curr_part_size;
             }
         }
 
         return ElementInfo { .part_index = UINT32_MAX, .element_offset = UINT32_MAX };
     }
 
+    // Uninitialized storage for elements kept inside the container object
+    template<typename ElementT, uint32_t Capacity>
+    struct inline_storage {
+        alignas(ElementT) unsigned char inline_bytes[Capacity * sizeof(ElementT)];
+
+        ElementT* inline_data() noexcept {
+            return std::launder(reinterpret_cast<ElementT*>(inline_bytes));
+        }
+
+        ElementT const* inline_data() const noexcept {
+            return std::launder(reinterpret_cast<ElementT const*>(inline_bytes));
+        }
+    };
+
+    // Empty base, so that containers without inline storage don't grow in size
+    template<typename ElementT>
+    struct inline_storage<ElementT, 0> {
+        ElementT* inline_data() noexcept {
+            return nullptr;
+        }
+
+        ElementT const* inline_data() const noexcept {
+            return nullptr;
+        }
+    };
+} // namespace partial_vector_detail
+
+// Minimum 2 elements per part
+// Up to InlineCapacity elements are stored inside the object itself; no heap allocations happen until they overflow into the first part.
+// PartMaxByteSize overrides PARTIAL_VECTOR_PART_MAX_BYTE_SIZE for a single container type.
+template<typename ElementT, uint32_t InlineCapacity = 0, uint32_t PartMaxByteSize = PARTIAL_VECTOR_PART_MAX_BYTE_SIZE,
+         typename = typename std::enable_if<(sizeof(ElementT) <= PartMaxByteSize / 2), ElementT>::type>
+class partial_vector : private partial_vector_detail::inline_storage<ElementT, InlineCapacity> {
+private:
+    static constexpr uint32_t max_part_size = PartMaxByteSize / sizeof(ElementT);
+
+    static_assert(InlineCapacity <= max_part_size, "InlineCapacity must fit into a single part");
+
+    std::vector<std::vector<ElementT>> parts;
+
+    size_t   size       = 0;
+    uint32_t part_count = 0;
+
+    mutable std::vector<size_t> part_offsets;
+
+#ifdef PARTIAL_VECTOR_ENABLE_STATS
+    mutable partial_vector_stats stats_counters;
+
+    void record_allocation(size_t old_capacity, size_t new_capacity) const noexcept {
+        if (new_capacity == old_capacity || new_capacity == 0) return;
+
+        stats_counters.allocations++;
+        stats_counters.allocated_bytes += new_capacity * sizeof(ElementT);
+    }
+
+    void record_find_element(uint32_t parts_scanned, size_t cached_offsets, size_t rebuilt_offsets) const noexcept {
+        stats_counters.find_element_calls++;
+        if (parts_scanned == 0) return;
+
+        uint32_t bucket = 0;
+        while (bucket + 1 < partial_vector_stats::probe_bucket_count && (parts_scanned >> (bucket + 1)) != 0)
+            bucket++;
+
+        stats_counters.find_element_parts_scanned[bucket]++;
+        // The estimated part index is always below cached_offsets when the cache is not empty
+        stats_counters.offset_cache_hits += cached_offsets > 0 && rebuilt_offsets == 0;
+        stats_counters.offset_cache_rebuilds += rebuilt_offsets;
+    }
+#endif
+
+    using ElementInfo = partial_vector_detail::ElementInfo;
+
+    // Elements live in the inline storage until the first part is allocated
+    bool is_inline() const noexcept {
+        return InlineCapacity > 0 && parts.empty();
+    }
+
+    size_t part_size(uint32_t part_index) const noexcept {
+        return is_inline() ? size : parts[part_index].size();
+    }
+
+    ElementT* part_data(uint32_t part_index) noexcept {
+        return is_inline() ? this->inline_data() : parts[part_index].data();
+    }
+
+    ElementT const* part_data(uint32_t part_index) const noexcept {
+        return is_inline() ? this->inline_data() : parts[part_index].data();
+    }
+
+    ElementT& element_at(ElementInfo const& elem_info) noexcept {
+        return part_data(elem_info.part_index)[elem_info.element_offset];
+    }
+
+    ElementT const& element_at(ElementInfo const& elem_info) const noexcept {
+        return part_data(elem_info.part_index)[elem_info.element_offset];
+    }
+
+    ElementInfo find_element(size_t element_index) const {
+        if (is_inline()) {
+            PARTIAL_VECTOR_STATS_ONLY(stats_counters.find_element_calls++;)
+            return ElementInfo { .part_index = 0, .element_offset = static_cast<uint32_t>(element_index) };
+        }
+
+#ifdef PARTIAL_VECTOR_ENABLE_STATS
+        // part_size callback is invoked once per scanned part
+        uint32_t    parts_scanned  = 0;
+        size_t      cached_offsets = part_offsets.size();
+        ElementInfo elem_info      = partial_vector_detail::find_element(part_offsets, part_count, max_part_size, element_index,
+                                                                         [this, &parts_scanned](uint32_t part_index) {
+                                                                             parts_scanned++;
+                                                                             return parts[part_index].size();
+                                                                         });
+
+        record_find_element(parts_scanned, cached_offsets, part_offsets.size() - cached_offsets);
+        return elem_info;
+#else
+        return partial_vector_detail::find_element(part_offsets, part_count, max_part_size, element_index,
+                                                   [this](uint32_t part_index) { return parts[part_index].size(); });
+#endif
+    }
+
+    void invalidate_part_offsets(size_t valid_offset_count) const noexcept {
+        if (part_offsets.size() <= valid_offset_count) return;
+
+        part_offsets.resize(valid_offset_count);
+        PARTIAL_VECTOR_STATS_ONLY(stats_counters.offset_cache_invalidations++;)
+    }
+
+    ElementInfo end_element() const noexcept {
+        if (is_inline() || part_count == 0) return ElementInfo { .part_index = 0, .element_offset = static_cast<uint32_t>(size) };
+
+        return ElementInfo {
+            .part_index     = part_count - 1,
+            .element_offset = static_cast<uint32_t>(parts[part_count - 1].size()),
+        };
+    }
+
+    // Moves inline elements into the first part
+    void spill_inline() {
+        if (!is_inline() || size == 0) return;
+
+        std::vector<ElementT> part;
+        part.reserve(std::min(max_part_size, InlineCapacity * 2));
+
+        ElementT* data = this->inline_data();
+        for (size_t i = 0; i < size; i++)
+            part.push_back(std::move(data[i]));
+        std::destroy_n(data, size);
+
+        PARTIAL_VECTOR_STATS_ONLY(record_allocation(0, part.capacity());)
+
+        parts.push_back(std::move(part));
+        part_count = 1;
+    }
+
+    static constexpr bool nothrow_move = InlineCapacity == 0 || std::is_nothrow_move_constructible_v<ElementT>;
+
+    // Takes over heap parts of another vector, inline elements are moved one by one.
+    // This vector must not hold any elements. Its size is committed only after inline elements are moved,
+    // so a throwing move leaves it empty.
+    void take_storage(partial_vector& another) noexcept(nothrow_move) {
+        if (another.is_inline()) {
+            parts.clear();
+            part_offsets.clear();
+            part_count = 0;
+
+            std::uninitialized_move_n(another.inline_data(), another.size, this->inline_data());
+            size = another.size;
+
+            std::destroy_n(another.inline_data(), another.size);
+            another.size = 0;
+            return;
+        }
+
+        parts        = std::move(another.parts);
+        size         = another.size;
+        part_count   = another.part_count;
+        part_offsets = std::move(another.part_offsets);
+
+        another.parts.clear();
+        another.part_offsets.clear();
+        another.size       = 0;
+        another.part_count = 0;
+    }
+
     ElementInfo next_element(ElementInfo const& current_element) const {
-        if (current_element.element_offset + 1 < parts[current_element.part_index].size())
+        if (current_element.element_offset + 1 < part_size(current_element.part_index))
             return ElementInfo { .part_index = current_element.part_index, .element_offset = current_element.element_offset + 1 };
         else
             return ElementInfo { .part_index = current_element.part_index + 1, .element_offset = 0 };
@@ -73,17 +284,17 @@ private:
             return ElementInfo { .part_index = current_element.part_index, .element_offset = current_element.element_offset - 1 };
         else
             return ElementInfo { .part_index     = current_element.part_index - 1,
-                                 .element_offset = static_cast<uint32_t>(parts[current_element.part_index - 1].size() - 1) };
+                                 .element_offset = static_cast<uint32_t>(part_size(current_element.part_index - 1) - 1) };
     }
 
 public:
     struct iterator {
     private:
-        partial_vector<ElementT>* p_vector;
-        ElementInfo               elem_info;
-        uint64_t                  elem_index;
+        partial_vector* p_vector;
+        ElementInfo     elem_info;
+        uint64_t        elem_index;
 
-        iterator(partial_vector<ElementT>& p_vector, ElementInfo elem_info, uint64_t elem_index) noexcept
+        iterator(partial_vector& p_vector, ElementInfo elem_info, uint64_t elem_index) noexcept
             : p_vector(&p_vector), elem_info(elem_info), elem_index(elem_index) {}
 
         friend partial_vector;
@@ -97,7 +308,7 @@ public:
         typedef ptrdiff_t                       difference_type;
 
         ElementT& operator*() noexcept {
-            return p_vector->parts[elem_info.part_index][elem_info.element_offset];
+            return p_vector->element_at(elem_info);
         }
 
         iterator operator+(uint64_t n) const noexcept {
@@ -162,11 +373,11 @@ public:
     };
     struct const_iterator {
     private:
-        const partial_vector<ElementT>* p_vector;
-        ElementInfo                     elem_info;
-        uint64_t                        elem_index;
+        const partial_vector* p_vector;
+        ElementInfo           elem_info;
+        uint64_t              elem_index;
 
-        const_iterator(partial_vector<ElementT> const& p_vector, ElementInfo elem_info, uint64_t elem_index) noexcept
+        const_iterator(partial_vector const& p_vector, ElementInfo elem_info, uint64_t elem_index) noexcept
             : p_vector(&p_vector), elem_info(elem_info), elem_index(elem_index) {}
 
         friend partial_vector;
@@ -180,7 +391,7 @@ public:
         typedef ptrdiff_t                       difference_type;
 
         ElementT const& operator*() const noexcept {
-            return p_vector->parts[elem_info.part_index][elem_info.element_offset];
+            return p_vector->element_at(elem_info);
         }
 
         const_iterator operator+(uint64_t n) const noexcept {
@@ -236,8 +447,16 @@ public:
         }
     };
 
-    explicit partial_vector(partial_vector<ElementT> const& another) noexcept
-        : parts(another.parts), part_offsets(another.part_offsets), part_count(another.part_count), size(another.size) {}
+    explicit partial_vector(partial_vector const& another)
+        : parts(another.parts), size(another.size), part_count(another.part_count), part_offsets(another.part_offsets) {
+        if (another.is_inline()) std::uninitialized_copy_n(another.inline_data(), size, this->inline_data());
+
+        PARTIAL_VECTOR_STATS_ONLY(for (auto const& part : parts) record_allocation(0, part.capacity());)
+    }
+
+    partial_vector(partial_vector&& another) noexcept(nothrow_move) {
+        take_storage(another);
+    }
 
     explicit partial_vector(size_t size = 0) {
         resize(size);
@@ -267,19 +486,66 @@ public:
             push_back(*iter);
     }
 
-    void reserve(size_t r_size) noexcept {
+    ~partial_vector() {
+        if (is_inline()) std::destroy_n(this->inline_data(), size);
+    }
+
+    partial_vector& operator=(partial_vector const& another) {
+        if (this == &another) return *this;
+
+        clear();
+
+        // Size is committed only after all elements are copied, so a throwing copy leaves this vector empty
+        if (another.is_inline()) {
+            std::uninitialized_copy_n(another.inline_data(), another.size, this->inline_data());
+            size = another.size;
+            return *this;
+        }
+
+        std::vector<std::vector<ElementT>> new_parts        = another.parts;
+        std::vector<size_t>                new_part_offsets = another.part_offsets;
+
+        parts        = std::move(new_parts);
+        size         = another.size;
+        part_count   = another.part_count;
+        part_offsets = std::move(new_part_offsets);
+
+        PARTIAL_VECTOR_STATS_ONLY(for (auto const& part : parts) record_allocation(0, part.capacity());)
+
+        return *this;
+    }
+
+    partial_vector& operator=(partial_vector&& another) noexcept(nothrow_move) {
+        if (this == &another) return *this;
+
+        if (is_inline()) {
+            std::destroy_n(this->inline_data(), size);
+            size = 0;
+        }
+
+        take_storage(another);
+
+        return *this;
+    }
+
+    // Parts are not allocated in advance: push_back allocates every part except the first one at full size when it is created
+    void reserve(size_t r_size) {
+        if (is_inline()) {
+            if (r_size <= InlineCapacity) return;
+            spill_inline();
+        }
+
         uint32_t parts_to_reserve = std::ceil(static_cast<double>(r_size) / max_part_size);
-        // parts.reserve(parts_to_reserve);
-        parts.resize(parts_to_reserve);
+        parts.reserve(parts_to_reserve);
         part_offsets.reserve(parts_to_reserve);
-
-        for (auto& part : parts)
-            part.reserve(max_part_size);
     }
 
     void shrink_to_fit() noexcept {
-        for (auto& part : parts)
+        for (auto& part : parts) {
+            PARTIAL_VECTOR_STATS_ONLY(size_t old_capacity = part.capacity();)
             part.shrink_to_fit();
+            PARTIAL_VECTOR_STATS_ONLY(record_allocation(old_capacity, part.capacity());)
+        }
 
         parts.shrink_to_fit();
         part_offsets.shrink_to_fit();
@@ -288,6 +554,22 @@ public:
     void resize(size_t new_size) {
         if (this->size == new_size) return;
 
+        if (is_inline()) {
+            if (new_size <= InlineCapacity) {
+                ElementT* data = this->inline_data();
+
+                if (new_size < this->size)
+                    std::destroy(data + new_size, data + this->size);
+                else
+                    std::uninitialized_value_construct(data + this->size, data + new_size);
+
+                this->size = new_size;
+                return;
+            }
+
+            spill_inline();
+        }
+
         if (new_size == 0) {
             part_count = 0;
             parts.resize(part_count);
@@ -302,13 +584,18 @@ public:
                 parts[i].resize(max_part_size);
 
             if (n_last_part_alloc_size > 0) parts[part_count - 1].resize(n_last_part_alloc_size);
+
+            PARTIAL_VECTOR_STATS_ONLY(for (auto const& part : parts) record_allocation(0, part.capacity());)
         } else if (new_size > this->size) {
             size_t size_to_alloc = new_size - this->size;
 
             uint32_t last_part_size = parts[part_count - 1].size();
             if (last_part_size < max_part_size) {
                 uint32_t alloc_size = std::min(static_cast<size_t>(max_part_size - last_part_size), size_to_alloc);
+
+                PARTIAL_VECTOR_STATS_ONLY(size_t old_capacity = parts[part_count - 1].capacity();)
                 parts[part_count - 1].resize(last_part_size + alloc_size);
+                PARTIAL_VECTOR_STATS_ONLY(record_allocation(old_capacity, parts[part_count - 1].capacity());)
 
                 size_to_alloc -= alloc_size;
             }
@@ -319,6 +606,7 @@ public:
 
                 parts.push_back(std::vector<ElementT>(alloc_size));
                 part_count++;
+                PARTIAL_VECTOR_STATS_ONLY(record_allocation(0, parts.back().capacity());)
 
                 size_to_alloc -= alloc_size;
             }
@@ -332,7 +620,7 @@ public:
                     size_to_remove -= part_size;
                     parts.pop_back();
                     part_count--;
-                    if (part_size == size_to_remove) break;
+                    if (size_to_remove == 0) break;
                 } else { // part_size > size_to_remove
                     parts[i].resize(part_size - size_to_remove);
                     break;
@@ -341,7 +629,7 @@ public:
         }
 
         part_offsets.reserve(new_size / max_part_size + 1);
-        part_offsets.resize(std::min(part_offsets.size(), static_cast<size_t>(part_count)));
+        invalidate_part_offsets(part_count);
 
         this->size = new_size;
     }
@@ -354,66 +642,123 @@ public:
         // if (Index > size) throw std::runtime_error("Index >= size + 1");
 
         if (position.elem_index == size) {
-            parts.push_back(std::vector<ElementT>({ element }));
-            part_count++;
-        } else { // Index < size
-            ElementInfo const& elem_info = position.elem_info;
-            auto&              part      = parts[elem_info.part_index];
-
-            if (part.size() == max_part_size) {
-                uint32_t part_n_index = elem_info.part_index + 1;
-
-                if (part_n_index < part_count && parts[part_n_index].size() < max_part_size) {
-                    parts[part_n_index].insert(parts[part_n_index].begin(), part[part.size() - 1]);
-                } else {
-                    parts.insert(parts.begin() + elem_info.part_index + 1,
-                                 std::vector<ElementT>(part.begin() + part.size() - 1, part.end()));
-                    part_count++;
-                }
+            push_back(std::move(element));
+            return;
+        }
+
+        if (is_inline()) {
+            if (size < InlineCapacity) {
+                ElementT* data = this->inline_data();
 
-                // Here 'part' may be undefined because of 'parts.insert' in 'else' branch
+                ::new (static_cast<void*>(data + size)) ElementT(std::move(data[size - 1]));
+                std::move_backward(data + position.elem_index, data + size - 1, data + size);
+                data[position.elem_index] = std::move(element);
 
-                auto& part_t = parts[elem_info.part_index];
-                part_t.erase(part_t.begin() + part_t.size() - 1);
+                PARTIAL_VECTOR_STATS_ONLY(stats_counters.insert_element_moves += size - position.elem_index;)
+                size++;
+                return;
             }
 
-            auto& part_t = parts[elem_info.part_index];
-            part_t.insert(part_t.begin() + elem_info.element_offset, element);
+            // Elements keep their offsets inside the first part, so position stays valid
+            PARTIAL_VECTOR_STATS_ONLY(stats_counters.insert_element_moves += size;)
+            spill_inline();
+        }
+
+        ElementInfo const& elem_info = position.elem_info;
+        auto&              part      = parts[elem_info.part_index];
+
+        if (part.size() == max_part_size) {
+            uint32_t part_n_index = elem_info.part_index + 1;
+
+            if (part_n_index < part_count && parts[part_n_index].size() < max_part_size) {
+                auto& part_n = parts[part_n_index];
 
-            part_offsets.resize(elem_info.part_index + 1);
+                PARTIAL_VECTOR_STATS_ONLY(size_t old_capacity = part_n.capacity();)
+                part_n.insert(part_n.begin(), part[part.size() - 1]);
+                PARTIAL_VECTOR_STATS_ONLY(record_allocation(old_capacity, part_n.capacity());)
+                PARTIAL_VECTOR_STATS_ONLY(stats_counters.insert_element_moves += part_n.size();)
+            } else {
+                parts.insert(parts.begin() + elem_info.part_index + 1,
+                             std::vector<ElementT>(part.begin() + part.size() - 1, part.end()));
+                part_count++;
+                PARTIAL_VECTOR_STATS_ONLY(record_allocation(0, parts[part_n_index].capacity());)
+                PARTIAL_VECTOR_STATS_ONLY(stats_counters.insert_element_moves++;)
+            }
+
+            // Here 'part' may be undefined because of 'parts.insert' in 'else' branch
+
+            auto& part_t = parts[elem_info.part_index];
+            part_t.erase(part_t.begin() + part_t.size() - 1);
         }
 
+        auto& part_t = parts[elem_info.part_index];
+
+        PARTIAL_VECTOR_STATS_ONLY(size_t old_capacity = part_t.capacity();)
+        part_t.insert(part_t.begin() + elem_info.element_offset, std::move(element));
+        PARTIAL_VECTOR_STATS_ONLY(record_allocation(old_capacity, part_t.capacity());)
+        PARTIAL_VECTOR_STATS_ONLY(stats_counters.insert_element_moves += part_t.size() - elem_info.element_offset - 1;)
+
+        invalidate_part_offsets(elem_info.part_index + 1);
+
         size++;
     }
 
     void remove(size_t index) {
         if (index >= size) throw std::runtime_error("Index >= size");
 
+        if (is_inline()) {
+            ElementT* data = this->inline_data();
+
+            std::move(data + index + 1, data + size, data + index);
+            std::destroy_at(data + size - 1);
+
+            size--;
+            return;
+        }
+
         ElementInfo elem_info = find_element(index);
         auto&       part      = parts[elem_info.part_index];
 
         part.erase(part.begin() + elem_info.element_offset);
-        if (part.empty()) parts.erase(parts.begin() + elem_info.part_index);
+        if (part.empty()) {
+            parts.erase(parts.begin() + elem_info.part_index);
+            part_count--;
+        }
 
-        part_offsets.resize(elem_info.part_index + 1);
+        invalidate_part_offsets(elem_info.part_index + 1);
         size--;
     }
 
     // Adding element via push_back is faster than [] operator
     void push_back(ElementT element) {
+        if (is_inline()) {
+            if (size < InlineCapacity) {
+                ::new (static_cast<void*>(this->inline_data() + size)) ElementT(std::move(element));
+                size++;
+                return;
+            }
+
+            spill_inline();
+        }
+
         if (size == 0) {
             part_count = 1;
             parts.resize(part_count);
-            parts[0].push_back(element);
+            parts[0].push_back(std::move(element));
+            PARTIAL_VECTOR_STATS_ONLY(record_allocation(0, parts[0].capacity());)
         } else {
             auto& part = parts[part_count - 1];
 
             if (part.size() < max_part_size) {
-                part.push_back(element);
+                PARTIAL_VECTOR_STATS_ONLY(size_t old_capacity = part.capacity();)
+                part.push_back(std::move(element));
+                PARTIAL_VECTOR_STATS_ONLY(record_allocation(old_capacity, part.capacity());)
             } else {
                 part_count = part_count + 1;
                 parts.resize(part_count);
-                parts[part_count - 1].push_back(element);
+                parts[part_count - 1].reserve(max_part_size);
+                parts[part_count - 1].push_back(std::move(element));
+                PARTIAL_VECTOR_STATS_ONLY(record_allocation(0, parts[part_count - 1].capacity());)
             }
         }
 
@@ -423,15 +768,13 @@ public:
     ElementT& operator[](size_t index) {
         if (index >= size) throw std::runtime_error("Index >= size");
 
-        ElementInfo elem_info = find_element(index);
-        return parts[elem_info.part_index][elem_info.element_offset];
+        return element_at(find_element(index));
     }
 
     ElementT const& operator[](size_t index) const {
         if (index >= size) throw std::runtime_error("Index >= size");
 
-        ElementInfo elem_info = find_element(index);
-        return parts[elem_info.part_index][elem_info.element_offset];
+        return element_at(find_element(index));
     }
 
     void get_contiguous_data(void* output, size_t start_index, size_t count) const {
@@ -442,12 +785,12 @@ public:
         size_t      size_to_read    = count;
         ElementInfo start_elem_info = find_element(start_index);
 
-        for (uint32_t i = start_elem_info.part_index; i < part_count; i++) {
-            auto&    part       = parts[i];
-            uint32_t elem_index = i == start_elem_info.part_index ? start_elem_info.element_offset : 0;
-            uint32_t elem_count = std::min(part.size() - elem_index, size_to_read);
+        for (uint32_t i = start_elem_info.part_index; size_to_read > 0; i++) {
+            ElementT const* data       = part_data(i);
+            uint32_t        elem_index = i == start_elem_info.part_index ? start_elem_info.element_offset : 0;
+            uint32_t        elem_count = std::min(part_size(i) - elem_index, size_to_read);
 
-            std::copy(part.begin() + elem_index, part.begin() + elem_index + elem_count, element_output);
+            std::copy(data + elem_index, data + elem_index + elem_count, element_output);
             element_output += elem_count;
 
             size_to_read -= elem_count;
@@ -482,6 +825,26 @@ public:
         return part_count;
     }
 
+#ifdef PARTIAL_VECTOR_ENABLE_STATS
+    partial_vector_stats stats() const noexcept {
+        partial_vector_stats snapshot = stats_counters;
+
+        for (uint32_t i = 0; i < part_count; i++) {
+            size_t bucket = parts[i].size() * partial_vector_stats::occupancy_bucket_count / max_part_size;
+            snapshot.part_occupancy[std::min(bucket, static_cast<size_t>(partial_vector_stats::occupancy_bucket_count - 1))]++;
+        }
+
+        snapshot.element_count = size;
+        snapshot.part_count    = part_count;
+
+        return snapshot;
+    }
+
+    void reset_stats() noexcept {
+        stats_counters = partial_vector_stats();
+    }
+#endif
+
     iterator begin() noexcept {
         return iterator(*this, ElementInfo { 0, 0 }, 0);
     }
@@ -491,21 +854,11 @@ public:
     }
 
     iterator end() noexcept {
-        return iterator(*this,
-                        ElementInfo {
-                            .part_index     = part_count - 1,
-                            .element_offset = static_cast<uint32_t>(parts[part_count - 1].size()),
-                        },
-                        size);
+        return iterator(*this, end_element(), size);
     }
 
     const_iterator end() const noexcept {
-        return const_iterator(*this,
-                              ElementInfo {
-                                  .part_index     = part_count - 1,
-                                  .element_offset = static_cast<uint32_t>(parts[part_count - 1].size()),
-                              },
-                              size);
+        return const_iterator(*this, end_element(), size);
     }
 };
 